@@ -0,0 +1,77 @@
+#include <bench/allocation_counter.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<uint64_t> s_allocations = 0;
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+#if defined(_MSC_VER)
+    return _aligned_malloc(size == 0 ? 1 : size, static_cast<std::size_t>(alignment));
+#else
+    // aligned_alloc requires size to be multiple of alignment
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    const std::size_t alignedSize = (size == 0 ? align : (size + align - 1) / align * align);
+    return std::aligned_alloc(align, alignedSize);
+#endif
+}
+
+void freeAligned(void* pointer)
+{
+#if defined(_MSC_VER)
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+}
+
+uint64_t allocationCount()
+{
+    return s_allocations.load(std::memory_order_relaxed);
+}
+
+// array and nothrow forms forward to these by default
+void* operator new(std::size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = allocateAligned(size, alignment))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    freeAligned(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    freeAligned(pointer);
+}
@@ -0,0 +1,5 @@
+#pragma once
+#include <cstdint>
+
+// number of global operator new calls since program start
+uint64_t allocationCount();
@@ -0,0 +1,38 @@
+#include <bench/bench.hpp>
+#include <renderer/render_system.hpp>
+
+namespace
+{
+// volatile, so compiler can not fold checks away
+volatile vk::Result s_success = vk::Result::eSuccess;
+volatile vk::Result s_suboptimal = vk::Result::eSuboptimalKHR;
+
+void criticalVulkanAssertSuccess(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        criticalVulkanAssert(s_success, "error in benchmark");
+    }
+}
+
+void criticalSwapchainAssertSuccess(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        criticalSwapchainAssert(s_success, "error in benchmark");
+    }
+}
+
+void criticalSwapchainAssertSuboptimal(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        criticalSwapchainAssert(s_suboptimal, "error in benchmark");
+    }
+}
+
+}
+
+BENCHMARK("assert/criticalVulkanAssert_success", criticalVulkanAssertSuccess);
+BENCHMARK("assert/criticalSwapchainAssert_success", criticalSwapchainAssertSuccess);
+BENCHMARK("assert/criticalSwapchainAssert_suboptimal", criticalSwapchainAssertSuboptimal);
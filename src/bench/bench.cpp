@@ -0,0 +1,198 @@
+#include <bench/bench.hpp>
+#include <bench/allocation_counter.hpp>
+#include <utils/assert.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+constexpr std::chrono::nanoseconds calibrationTime = std::chrono::milliseconds(50);
+constexpr std::chrono::nanoseconds measurementTime = std::chrono::milliseconds(200);
+constexpr int measurementRepeats = 5;
+// allows one-off allocations amortized over iterations, e.g. lazy initialization
+constexpr double allocationsTolerance = 0.01;
+
+std::chrono::nanoseconds timeIterations(BenchmarkBody body, uint64_t iterations)
+{
+    auto begin = std::chrono::steady_clock::now();
+    body(iterations);
+    return std::chrono::steady_clock::now() - begin;
+}
+
+// reads value following "key": in flat json object
+std::string extractField(const std::string& object, const std::string& key)
+{
+    size_t position = object.find("\"" + key + "\"");
+    if (position == std::string::npos)
+    {
+        return {};
+    }
+    position = object.find(':', position);
+    position = object.find_first_not_of(" \t\n\"", position + 1);
+    size_t end = object.find_first_of(",}\"\n", position);
+    return object.substr(position, end - position);
+}
+
+}
+
+std::vector<Benchmark>& benchmarks()
+{
+    static std::vector<Benchmark> s_benchmarks;
+    return s_benchmarks;
+}
+
+BenchmarkRegistrar::BenchmarkRegistrar(const char* name, BenchmarkBody body, BenchmarkAvailable available)
+{
+    benchmarks().push_back(Benchmark{name, body, available});
+}
+
+BenchmarkResult runBenchmark(const Benchmark& benchmark)
+{
+    uint64_t iterations = 1;
+    std::chrono::nanoseconds elapsed = timeIterations(benchmark.body, iterations);
+    while (elapsed < calibrationTime)
+    {
+        iterations *= 2;
+        elapsed = timeIterations(benchmark.body, iterations);
+    }
+    iterations = std::max<uint64_t>(1, iterations * measurementTime.count() / elapsed.count());
+
+    BenchmarkResult result{benchmark.name, 0.0, 0.0};
+    for (int i = 0; i < measurementRepeats; ++i)
+    {
+        const uint64_t allocationsBefore = allocationCount();
+        elapsed = timeIterations(benchmark.body, iterations);
+        const uint64_t allocations = allocationCount() - allocationsBefore;
+        const double nsPerOp = static_cast<double>(elapsed.count()) / iterations;
+        // minimum is least affected by scheduler noise
+        if (i == 0 || nsPerOp < result.nsPerOp)
+        {
+            result.nsPerOp = nsPerOp;
+            result.allocationsPerOp = static_cast<double>(allocations) / iterations;
+        }
+    }
+    return result;
+}
+
+void writeResults(std::ostream& file, const std::vector<BenchmarkResult>& results)
+{
+    file << "{\"benchmarks\":[";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        file << (i == 0 ? "\n" : ",\n")
+            << "{\"name\":\"" << results[i].name << "\""
+            << ",\"ns_per_op\":" << results[i].nsPerOp
+            << ",\"allocations_per_op\":" << results[i].allocationsPerOp << "}";
+    }
+    file << "\n]}\n";
+}
+
+bool parseNumber(const std::string& text, double& value)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return *end == '\0';
+}
+
+std::optional<std::vector<BenchmarkResult>> readResults(const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        fprintf(stderr, "failed to open %s\n", path.string().c_str());
+        return std::nullopt;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    const std::string text = content.str();
+
+    // benchmarks array is list of flat objects, written by writeResults
+    size_t arrayBegin = text.find("\"benchmarks\"");
+    if (arrayBegin != std::string::npos)
+    {
+        arrayBegin = text.find_first_not_of(" \t\n", text.find(':', arrayBegin) + 1);
+    }
+    const size_t arrayEnd = arrayBegin == std::string::npos ? arrayBegin : text.find(']', arrayBegin);
+    if (arrayBegin == std::string::npos || text[arrayBegin] != '[' || arrayEnd == std::string::npos)
+    {
+        fprintf(stderr, "%s has no benchmarks array\n", path.string().c_str());
+        return std::nullopt;
+    }
+
+    std::vector<BenchmarkResult> results;
+    size_t begin = text.find('{', arrayBegin);
+    while (begin < arrayEnd)
+    {
+        size_t end = text.find('}', begin);
+        end = end < arrayEnd ? end : std::string::npos;
+        BenchmarkResult result;
+        const std::string object = text.substr(begin, end == std::string::npos ? end : end - begin + 1);
+        result.name = extractField(object, "name");
+        if (end == std::string::npos || result.name.empty() ||
+                !parseNumber(extractField(object, "ns_per_op"), result.nsPerOp) ||
+                !parseNumber(extractField(object, "allocations_per_op"), result.allocationsPerOp))
+        {
+            fprintf(stderr, "malformed entry in %s: %s\n", path.string().c_str(), object.c_str());
+            return std::nullopt;
+        }
+        results.push_back(std::move(result));
+        begin = text.find('{', end);
+    }
+    if (results.empty())
+    {
+        fprintf(stderr, "%s has no benchmark entries\n", path.string().c_str());
+        return std::nullopt;
+    }
+    return results;
+}
+
+bool compareResults(const std::vector<BenchmarkResult>& results,
+        const std::vector<BenchmarkResult>& baseline, double threshold, const std::string& filter)
+{
+    bool passed = true;
+    for (const auto& base : baseline)
+    {
+        if (base.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+        auto result = std::find_if(results.begin(), results.end(), [&base](const BenchmarkResult& entry)
+                {
+                    return entry.name == base.name;
+                });
+        if (result == results.end())
+        {
+            // skipped or removed benchmark would otherwise pass unnoticed
+            printf("%-40s missing, present in baseline  REGRESSED\n", base.name.c_str());
+            passed = false;
+        }
+    }
+    for (const auto& result : results)
+    {
+        auto base = std::find_if(baseline.begin(), baseline.end(), [&result](const BenchmarkResult& entry)
+                {
+                    return entry.name == result.name;
+                });
+        if (base == baseline.end())
+        {
+            printf("%-40s no baseline\n", result.name.c_str());
+            continue;
+        }
+        const bool timeRegressed = result.nsPerOp > base->nsPerOp * (1.0 + threshold);
+        const bool allocationsRegressed = result.allocationsPerOp > base->allocationsPerOp + allocationsTolerance;
+        printf("%-40s %10.2f ns (baseline %10.2f) %8.2f allocs (baseline %8.2f)%s\n",
+                result.name.c_str(), result.nsPerOp, base->nsPerOp,
+                result.allocationsPerOp, base->allocationsPerOp,
+                timeRegressed || allocationsRegressed ? "  REGRESSED" : "");
+        passed = passed && !timeRegressed && !allocationsRegressed;
+    }
+    return passed;
+}
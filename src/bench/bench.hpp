@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct BenchmarkResult
+{
+    std::string name;
+    double nsPerOp;
+    double allocationsPerOp;
+};
+
+// body runs given number of iterations of measured operation
+using BenchmarkBody = void(*)(uint64_t iterations);
+
+// returns false if benchmark can not run on this host, e.g. without vulkan device
+using BenchmarkAvailable = bool(*)();
+
+struct Benchmark
+{
+    const char* name;
+    BenchmarkBody body;
+    // nullptr if benchmark can always run
+    BenchmarkAvailable available;
+};
+
+std::vector<Benchmark>& benchmarks();
+
+// registers benchmark during static initialization
+struct BenchmarkRegistrar
+{
+    BenchmarkRegistrar(const char* name, BenchmarkBody body, BenchmarkAvailable available = nullptr);
+};
+
+#define BENCHMARK(name, body) \
+    static BenchmarkRegistrar s_registrar_##body(name, body)
+
+#define BENCHMARK_IF(name, body, available) \
+    static BenchmarkRegistrar s_registrar_##body(name, body, available)
+
+BenchmarkResult runBenchmark(const Benchmark& benchmark);
+
+void writeResults(std::ostream& file, const std::vector<BenchmarkResult>& results);
+// reports problem to stderr and returns nullopt if file is missing or malformed
+std::optional<std::vector<BenchmarkResult>> readResults(const std::filesystem::path& path);
+
+// whole text should be number
+bool parseNumber(const std::string& text, double& value);
+
+// prints comparison, returns false if any metric regressed more than threshold (0.1 is 10%),
+// allocations per op grew noticeably or baseline benchmark matching filter has no result
+bool compareResults(const std::vector<BenchmarkResult>& results,
+        const std::vector<BenchmarkResult>& baseline, double threshold, const std::string& filter);
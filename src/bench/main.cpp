@@ -0,0 +1,110 @@
+#include <bench/bench.hpp>
+#include <utils/executable_folder.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// usage: bench [--filter substring] [--out results.json] [--baseline baseline.json] [--threshold 0.1]
+// exits with 1 if baseline comparison found regression, with 2 on invalid arguments or baseline
+int main(int argc, char* argv[])
+{
+    // render benchmarks load shaders relative to executable
+    setExecutableFolder(argv[0]);
+    std::string filter;
+    std::string outPath;
+    std::string baselinePath;
+    double threshold = 0.1;
+    for (int i = 1; i < argc; i += 2)
+    {
+        if (i + 1 == argc)
+        {
+            fprintf(stderr, "missing value for %s\n", argv[i]);
+            return 2;
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0)
+        {
+            filter = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--out") == 0)
+        {
+            outPath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--baseline") == 0)
+        {
+            baselinePath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--threshold") == 0)
+        {
+            if (!parseNumber(argv[i + 1], threshold) || threshold < 0.0)
+            {
+                fprintf(stderr, "threshold should be non-negative number, got %s\n", argv[i + 1]);
+                return 2;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    // output and baseline are opened first, so bad paths fail before benchmarks run
+    std::ofstream outFile;
+    if (!outPath.empty())
+    {
+        outFile.open(outPath);
+        if (!outFile.is_open())
+        {
+            fprintf(stderr, "failed to open %s\n", outPath.c_str());
+            return 2;
+        }
+    }
+
+    std::optional<std::vector<BenchmarkResult>> baseline;
+    if (!baselinePath.empty())
+    {
+        baseline = readResults(baselinePath);
+        if (!baseline.has_value())
+        {
+            return 2;
+        }
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (const auto& benchmark : benchmarks())
+    {
+        if (std::string(benchmark.name).find(filter) == std::string::npos)
+        {
+            continue;
+        }
+        if (benchmark.available != nullptr && !benchmark.available())
+        {
+            printf("%-40s skipped\n", benchmark.name);
+            continue;
+        }
+        results.push_back(runBenchmark(benchmark));
+        printf("%-40s %10.2f ns/op %8.2f allocs/op\n", results.back().name.c_str(),
+                results.back().nsPerOp, results.back().allocationsPerOp);
+    }
+
+    if (!outPath.empty())
+    {
+        writeResults(outFile, results);
+        outFile.close();
+        if (outFile.fail())
+        {
+            fprintf(stderr, "failed to write %s\n", outPath.c_str());
+            return 2;
+        }
+    }
+    if (!baselinePath.empty())
+    {
+        printf("\ncomparing with %s, threshold %.0f%%\n", baselinePath.c_str(), threshold * 100);
+        if (!compareResults(results, baseline.value(), threshold, filter))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <bench/bench.hpp>
+#include <renderer/render_system.hpp>
+#include <cstdlib>
+
+namespace
+{
+constexpr size_t windowWidth = 800;
+constexpr size_t windowHeight = 600;
+
+vkfw::UniqueWindow s_window;
+bool s_renderSystemStarted = false;
+
+// hidden, so benchmarks run without stealing focus, empty on failure
+vkfw::UniqueWindow createHiddenWindow()
+{
+    vkfw::WindowHints hints;
+    hints.visible = false;
+    auto[result, window] = vkfw::createWindowUnique(windowWidth, windowHeight, "Chess bench", hints);
+    if (result != vkfw::Result::eSuccess)
+    {
+        return {};
+    }
+    return std::move(window);
+}
+
+void startRenderSystem()
+{
+    s_window = createHiddenWindow();
+    fassert(static_cast<bool>(s_window), "error creating bench window");
+    // validation layers allocate through same operator new, so they would be counted as app allocations
+    RenderSystem::init(s_window.get(), false);
+    s_renderSystemStarted = true;
+}
+
+void stopRenderSystem()
+{
+    if (s_renderSystemStarted)
+    {
+        RenderSystem::shutdown();
+        s_window.reset();
+        s_renderSystemStarted = false;
+    }
+}
+
+// render benchmarks are skipped on hosts without display or suitable vulkan device
+bool isRenderingAvailable()
+{
+    static const bool available = []()
+    {
+        if (vkfw::init() != vkfw::Result::eSuccess)
+        {
+            return false;
+        }
+        // render system has to be destroyed before statics it depends on
+        std::atexit(stopRenderSystem);
+        vkfw::UniqueWindow window = createHiddenWindow();
+        return static_cast<bool>(window) && RenderSystem::isSupported(window.get());
+    }();
+    return available;
+}
+
+// window creation, instance and device setup and first frame.
+// includes shutdown, which also waits until first frame is finished
+void startupToFirstFrame(uint64_t iterations)
+{
+    stopRenderSystem();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        startRenderSystem();
+        RenderSystem::instance().update(0.0f);
+        stopRenderSystem();
+    }
+}
+
+// one op is one RenderSystem::update, so allocations per op are allocations per frame
+// made through operator new, driver allocations with malloc are not counted.
+// frames are bound by vsync if surface supports only fifo present mode
+void renderFrames(uint32_t boardCount, uint64_t iterations)
+{
+    if (!s_renderSystemStarted)
+    {
+        startRenderSystem();
+    }
+    RenderSystem& renderSystem = RenderSystem::instance();
+    renderSystem.setBoardCount(boardCount);
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        criticalAssertEqual(vkfw::pollEvents(), vkfw::Result::eSuccess, "error in glfwPollEvents");
+        renderSystem.update(0.0f);
+    }
+}
+
+void renderFramesOneBoard(uint64_t iterations)
+{
+    renderFrames(1, iterations);
+}
+
+// compared with render/frame_1_board, frame time should stay flat
+void renderFrames256Boards(uint64_t iterations)
+{
+    renderFrames(256, iterations);
+}
+
+}
+
+BENCHMARK_IF("render/startup_to_first_frame", startupToFirstFrame, isRenderingAvailable);
+BENCHMARK_IF("render/frame_1_board", renderFramesOneBoard, isRenderingAvailable);
+BENCHMARK_IF("render/frame_256_boards", renderFrames256Boards, isRenderingAvailable);
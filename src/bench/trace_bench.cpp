@@ -0,0 +1,29 @@
+#include <bench/bench.hpp>
+#include <utils/trace.hpp>
+
+namespace
+{
+// ring buffer is cleared before it fills, so every zone takes recording path
+constexpr uint64_t zonesBetweenClears = 4096;
+
+volatile uint64_t s_sink = 0;
+
+// measures zone overhead, or nothing when tracing is compiled out
+void traceZone(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        {
+            TRACE_ZONE("bench");
+            s_sink = i;
+        }
+        if (i % zonesBetweenClears == 0)
+        {
+            TRACE_CLEAR();
+        }
+    }
+}
+
+}
+
+BENCHMARK("trace/zone", traceZone);
@@ -1,11 +1,30 @@
 #include <vkfw/vkfw.hpp>
 #include <utils/assert.hpp>
 #include <utils/executable_folder.hpp>
+#include <utils/trace.hpp>
 #include <renderer/render_system.hpp>
+#include <cstdlib>
 
-void criticalVkfwAssert(vkfw::Result received, std::string message)
+void criticalVkfwAssert(vkfw::Result received, const char* message)
 {
-    criticalAssertEqual(received, vkfw::Result::eSuccess, std::move(message));
+    criticalAssertEqual(received, vkfw::Result::eSuccess, message);
+}
+
+// boards are drawn in grid, count is limited to keep them visible
+constexpr unsigned long maxBoardCount = 1024;
+
+// usage: chess [board count]
+uint32_t parseBoardCount(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        return 1;
+    }
+    char* end = nullptr;
+    const unsigned long boardCount = std::strtoul(argv[1], &end, 10);
+    fassert(*end == '\0' && boardCount != 0 && boardCount <= maxBoardCount,
+            "usage: chess [board count], board count should be from 1 to 1024");
+    return static_cast<uint32_t>(boardCount);
 }
 
 vkfw::UniqueWindow initWindow()
@@ -18,10 +37,12 @@ vkfw::UniqueWindow initWindow()
 int main(int argc, char* argv[])
 {
     setExecutableFolder(argv[0]);
+    const uint32_t boardCount = parseBoardCount(argc, argv);
     criticalVkfwAssert(vkfw::init(), "error in glfw init");
     vkfw::UniqueWindow mainWindow = initWindow();
     RenderSystem::init(mainWindow.get());
     RenderSystem& renderSystem = RenderSystem::instance();
+    renderSystem.setBoardCount(boardCount);
     while (true)
     {
         auto[shouldCloseResult, shouldClose] = mainWindow->shouldClose();
@@ -37,4 +58,5 @@ int main(int argc, char* argv[])
             renderSystem.update(0.0f);
         }
     }
+    TRACE_FLUSH(getExecutableFolder() / "trace.json");
 }
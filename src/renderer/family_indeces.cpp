@@ -1,13 +1,18 @@
 #include <renderer/family_indeces.hpp>
+#include <algorithm>
 
-FamilyIndeces::FamilyIndeces(uint32_t graphicsFamily, uint32_t presentationFamily) :
+FamilyIndeces::FamilyIndeces(uint32_t graphicsFamily, uint32_t presentationFamily,
+        uint32_t transferFamily, uint32_t computeFamily) :
     graphicsFamily(graphicsFamily),
-    presentationFamily(presentationFamily)
+    presentationFamily(presentationFamily),
+    transferFamily(transferFamily),
+    computeFamily(computeFamily)
 {
-    indexes.push_back(graphicsFamily);
-    if (graphicsFamily != presentationFamily)
+    for (uint32_t family : {graphicsFamily, presentationFamily, transferFamily, computeFamily})
     {
-        indexes.push_back(presentationFamily);
+        if (std::find(indexes.begin(), indexes.end(), family) == indexes.end())
+        {
+            indexes.push_back(family);
+        }
     }
 }
-
@@ -5,14 +5,18 @@
 struct FamilyIndeces
 {
     FamilyIndeces() = default;
-    FamilyIndeces(uint32_t graphicsFamily, uint32_t presentationFamily);
+    FamilyIndeces(uint32_t graphicsFamily, uint32_t presentationFamily,
+            uint32_t transferFamily, uint32_t computeFamily);
     FamilyIndeces(const FamilyIndeces&) = default;
     FamilyIndeces(FamilyIndeces&&) = default;
     FamilyIndeces& operator=(const FamilyIndeces&) = default;
     FamilyIndeces& operator=(FamilyIndeces&&) = default;
+    // unique families, one queue is created for each
     std::vector<uint32_t> indexes;
     uint32_t graphicsFamily;
     uint32_t presentationFamily;
+    // equal to graphicsFamily when device has no dedicated family
+    uint32_t transferFamily;
+    uint32_t computeFamily;
 
 };
-
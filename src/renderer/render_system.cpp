@@ -1,16 +1,22 @@
 #include <renderer/render_system.hpp>
 #include <utils/executable_folder.hpp>
+#include <utils/trace.hpp>
 #include <optional>
 #include <filesystem>
 #include <array>
 #include <tuple>
 #include <fstream>
 #include <iostream>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 namespace
 {
-constexpr bool enableVulkanDebug = true;
 constexpr size_t parallelFrames = 2;
+constexpr uint32_t squaresPerBoard = 64;
+constexpr uint32_t verticesPerSquare = 6;
 
 std::unique_ptr<RenderSystem> s_instance;
 
@@ -21,6 +27,11 @@ void extractResult(std::tuple<Result&, T&>&& tuple, ResultValue<T> result)
     std::get<1>(tuple) = std::move(result.value);
 }
 
+vk::ApplicationInfo makeApplicationInfo()
+{
+    return vk::ApplicationInfo("Chess", VK_MAKE_VERSION(1, 0, 0), "None", VK_MAKE_VERSION(1, 0, 0), VK_API_VERSION_1_1);
+}
+
 bool isRequiredDeviceExtentionsSupported(vk::PhysicalDevice physicalDevice)
 {
     auto[getExtentionsResult, extentions] = physicalDevice.enumerateDeviceExtensionProperties();
@@ -31,6 +42,33 @@ bool isRequiredDeviceExtentionsSupported(vk::PhysicalDevice physicalDevice)
             }) != extentions.end();
 }
 
+// prefers family that has requiredFlags and none of excludedFlags,
+// so work submitted there runs alongside graphics
+uint32_t findDedicatedFamily(const std::vector<vk::QueueFamilyProperties>& queueFamiliesProperties,
+        vk::QueueFlags requiredFlags, vk::QueueFlags excludedFlags, uint32_t fallbackFamily)
+{
+    for (uint32_t i = 0; i < queueFamiliesProperties.size(); ++i)
+    {
+        const vk::QueueFlags flags = queueFamiliesProperties[i].queueFlags;
+        if ((flags & requiredFlags) == requiredFlags && !(flags & excludedFlags))
+        {
+            return i;
+        }
+    }
+    return fallbackFamily;
+}
+
+FamilyIndeces makeFamilyIndeces(const std::vector<vk::QueueFamilyProperties>& queueFamiliesProperties,
+        uint32_t graphicsFamily, uint32_t presentationFamily)
+{
+    // graphics family supports transfer and compute, so it is used on single queue devices
+    const uint32_t transferFamily = findDedicatedFamily(queueFamiliesProperties,
+            vk::QueueFlagBits::eTransfer, vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute, graphicsFamily);
+    const uint32_t computeFamily = findDedicatedFamily(queueFamiliesProperties,
+            vk::QueueFlagBits::eCompute, vk::QueueFlagBits::eGraphics, graphicsFamily);
+    return FamilyIndeces{graphicsFamily, presentationFamily, transferFamily, computeFamily};
+}
+
 std::optional<FamilyIndeces> getFamilyIndeces(vk::PhysicalDevice physicalDevice, vk::SurfaceKHR surface)
 {
     auto queueFamiliesProperties = physicalDevice.getQueueFamilyProperties();
@@ -49,7 +87,7 @@ std::optional<FamilyIndeces> getFamilyIndeces(vk::PhysicalDevice physicalDevice,
             vk::QueueFlagBits::eGraphics; 
         if (surfaceSupported && graphicsSupported)
         {
-            return FamilyIndeces{i, i};
+            return makeFamilyIndeces(queueFamiliesProperties, i, i);
         }
         else
         {
@@ -66,7 +104,7 @@ std::optional<FamilyIndeces> getFamilyIndeces(vk::PhysicalDevice physicalDevice,
     if (indexGraphicsSupported < queueFamiliesProperties.size() &&
         indexSurfaceSupported < queueFamiliesProperties.size())
     {
-        return FamilyIndeces{indexGraphicsSupported, indexSurfaceSupported};
+        return makeFamilyIndeces(queueFamiliesProperties, indexGraphicsSupported, indexSurfaceSupported);
     }
     else
     {
@@ -83,6 +121,89 @@ bool surfaceAndSwapChainCompatible(vk::PhysicalDevice physicalDevice, vk::Surfac
     return !surfaceFormats.empty() && !presentModes.empty();
 }
 
+// family indeces if device can render to surface
+std::optional<FamilyIndeces> getSuitableFamilyIndeces(vk::PhysicalDevice physicalDevice, vk::SurfaceKHR surface)
+{
+    if (!isRequiredDeviceExtentionsSupported(physicalDevice) ||
+        !surfaceAndSwapChainCompatible(physicalDevice, surface))
+    {
+        return std::nullopt;
+    }
+    return getFamilyIndeces(physicalDevice, surface);
+}
+
+// compared lexicographically: device type, device local memory, max 2D image size
+using DeviceScore = std::tuple<int, vk::DeviceSize, uint32_t>;
+
+int rankDeviceType(vk::PhysicalDeviceType type)
+{
+    switch (type)
+    {
+    case vk::PhysicalDeviceType::eDiscreteGpu:
+        return 4;
+    case vk::PhysicalDeviceType::eIntegratedGpu:
+        return 3;
+    case vk::PhysicalDeviceType::eVirtualGpu:
+        return 2;
+    case vk::PhysicalDeviceType::eCpu:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+DeviceScore scorePhysicalDevice(vk::PhysicalDevice physicalDevice)
+{
+    const vk::PhysicalDeviceProperties properties = physicalDevice.getProperties();
+    const vk::PhysicalDeviceMemoryProperties memoryProperties = physicalDevice.getMemoryProperties();
+    vk::DeviceSize deviceLocalMemory = 0;
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i)
+    {
+        if (memoryProperties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+        {
+            deviceLocalMemory += memoryProperties.memoryHeaps[i].size;
+        }
+    }
+    return {rankDeviceType(properties.deviceType), deviceLocalMemory, properties.limits.maxImageDimension2D};
+}
+
+// lowercase hex without dashes, empty if device does not support vulkan 1.1
+std::string getDeviceUuid(vk::PhysicalDevice physicalDevice)
+{
+    if (physicalDevice.getProperties().apiVersion < VK_API_VERSION_1_1)
+    {
+        return {};
+    }
+    auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>();
+    const auto& uuid = properties.get<vk::PhysicalDeviceIDProperties>().deviceUUID;
+    std::string result;
+    char byteHex[3];
+    for (size_t i = 0; i < VK_UUID_SIZE; ++i)
+    {
+        std::snprintf(byteHex, sizeof(byteHex), "%02x", uuid[i]);
+        result += byteHex;
+    }
+    return result;
+}
+
+// override is either part of device name or device uuid
+bool matchesDeviceOverride(vk::PhysicalDevice physicalDevice, const std::string& deviceOverride)
+{
+    if (std::strstr(physicalDevice.getProperties().deviceName, deviceOverride.c_str()) != nullptr)
+    {
+        return true;
+    }
+    std::string uuid;
+    for (char c : deviceOverride)
+    {
+        if (c != '-')
+        {
+            uuid += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    return uuid == getDeviceUuid(physicalDevice);
+}
+
 vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& formats)
 {
     for (auto& format : formats)
@@ -148,8 +269,8 @@ std::vector<char> readFile(std::filesystem::path filename)
 }
 
 // if it is possible to fill parameters without creating anything, we should do this
-RenderSystem::RenderParametersCache::RenderParametersCache(RenderSystem& owner) :
-    appInfo("Chess", VK_MAKE_VERSION(1, 0, 0), "None", VK_MAKE_VERSION(1, 0, 0), VK_API_VERSION_1_1),
+RenderSystem::RenderParametersCache::RenderParametersCache(RenderSystem& owner, bool enableValidation) :
+    appInfo(makeApplicationInfo()),
     deviceExtentions({VK_KHR_SWAPCHAIN_EXTENSION_NAME}),
     imageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1),
     colorAttachment({}, {}, vk::SampleCountFlagBits::e1, 
@@ -181,6 +302,8 @@ RenderSystem::RenderParametersCache::RenderParametersCache(RenderSystem& owner)
             false, vk::LogicOp::eCopy, 1, &colorBlendAttachment,
             {0.0f, 0.0f, 0.0f, 0.0f}),
     dynamicStateInfo({}, 1, dynamicStates),
+    pushConstantRange(vk::ShaderStageFlagBits::eVertex, 0, sizeof(BoardLayout)),
+    pipelineLayoutInfo({}, 0, nullptr, 1, &pushConstantRange),
     pipelineInfo({}, 2, 
             shaderStageInfos, &vertexInputStageInfo, &inputAssemplyStateInfo,
             nullptr, &viewportStageInfo, &rasterizerInfo, &multisamplingInfo, 
@@ -191,12 +314,26 @@ RenderSystem::RenderParametersCache::RenderParametersCache(RenderSystem& owner)
     uint32_t glfwExtentionCount = 0;
     const char * const* glfwExtentions = vkfw::getRequiredInstanceExtensions(&glfwExtentionCount);
     instanceExtentions.assign(glfwExtentions, glfwExtentions + glfwExtentionCount);
-    // TODO: Check if layers exsists
-    enabledLayers = {
-        "VK_LAYER_KHRONOS_validation",
-        "VK_LAYER_LUNARG_standard_validation",
-        // "VK_LAYER_LUNARG_api_dump"
-    };
+    if (enableValidation)
+    {
+        auto[getLayersResult, layers] = vk::enumerateInstanceLayerProperties();
+        criticalVulkanAssert(getLayersResult, "error enumerating instance layers");
+        // missing layers are skipped, VK_LAYER_LUNARG_standard_validation is gone from recent SDKs
+        for (const char* layer : {
+                "VK_LAYER_KHRONOS_validation",
+                "VK_LAYER_LUNARG_standard_validation",
+                // "VK_LAYER_LUNARG_api_dump"
+                })
+        {
+            if (std::find_if(layers.begin(), layers.end(), [layer](const vk::LayerProperties& prop)
+                    {
+                        return std::strcmp(prop.layerName, layer) == 0;
+                    }) != layers.end())
+            {
+                enabledLayers.push_back(layer);
+            }
+        }
+    }
     instanceCreateInfo.pApplicationInfo = &appInfo;
     instanceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(instanceExtentions.size());
     instanceCreateInfo.ppEnabledExtensionNames = instanceExtentions.data();
@@ -205,11 +342,8 @@ RenderSystem::RenderParametersCache::RenderParametersCache(RenderSystem& owner)
 
     deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtentions.size());
     deviceCreateInfo.ppEnabledExtensionNames = deviceExtentions.data();
-    if (enableVulkanDebug)
-    {
-        deviceCreateInfo.enabledLayerCount = static_cast<uint32_t>(enabledLayers.size());
-        deviceCreateInfo.ppEnabledLayerNames = enabledLayers.data();
-    }
+    deviceCreateInfo.enabledLayerCount = static_cast<uint32_t>(enabledLayers.size());
+    deviceCreateInfo.ppEnabledLayerNames = enabledLayers.data();
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
 
     swapchainCreateInfo.imageArrayLayers = 1;
@@ -263,6 +397,7 @@ void RenderSystem::RenderParametersCache::updatePhysicalDeviceDependentPropertie
     vk::PresentModeKHR presentMode = chooseSwapPresentMode(presentModes);
     windowExtent = getSwapExtent2D(windowExtent, capabilities);
 
+    swapchainCreateInfo.imageExtent = windowExtent;
     swapchainCreateInfo.minImageCount = minImageCount;
     swapchainCreateInfo.imageFormat = surfaceFormat.format;
     swapchainCreateInfo.imageColorSpace = surfaceFormat.colorSpace;
@@ -270,9 +405,20 @@ void RenderSystem::RenderParametersCache::updatePhysicalDeviceDependentPropertie
     swapchainCreateInfo.presentMode = presentMode;
 }
 
+void RenderSystem::RenderParametersCache::updateSurfaceCapabilitiesDependentProperties()
+{
+    auto[getCapabilitiesResult, capabilities] =
+        owner.m_physicalDevice.getSurfaceCapabilitiesKHR(owner.m_surface.get());
+    criticalVulkanAssert(getCapabilitiesResult, "error receiving capabilities");
+    windowExtent = getSwapExtent2D(windowExtent, capabilities);
+    swapchainCreateInfo.imageExtent = windowExtent;
+    swapchainCreateInfo.preTransform = capabilities.currentTransform;
+}
+
 void RenderSystem::RenderParametersCache::updateQueueDependentProperties()
 {
-    float queuePriority = 1.0f;
+    // static, because pointer to it is read later in createDevice
+    static constexpr float queuePriority = 1.0f;
     queueInfos.clear();
     queueInfos.reserve(owner.m_familyIndeces.indexes.size());
     for (uint32_t index : owner.m_familyIndeces.indexes)
@@ -283,8 +429,22 @@ void RenderSystem::RenderParametersCache::updateQueueDependentProperties()
     deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueInfos.size());
     deviceCreateInfo.pQueueCreateInfos = queueInfos.data();
 
-    swapchainCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(owner.m_familyIndeces.indexes.size());
-    swapchainCreateInfo.pQueueFamilyIndices = owner.m_familyIndeces.indexes.data();
+    // only graphics and present queues use swapchain images, concurrent sharing
+    // avoids ownership transfer between them when families differ
+    swapchainQueueFamilies[0] = owner.m_familyIndeces.graphicsFamily;
+    swapchainQueueFamilies[1] = owner.m_familyIndeces.presentationFamily;
+    if (owner.m_familyIndeces.graphicsFamily != owner.m_familyIndeces.presentationFamily)
+    {
+        swapchainCreateInfo.imageSharingMode = vk::SharingMode::eConcurrent;
+        swapchainCreateInfo.queueFamilyIndexCount = 2;
+        swapchainCreateInfo.pQueueFamilyIndices = swapchainQueueFamilies;
+    }
+    else
+    {
+        swapchainCreateInfo.imageSharingMode = vk::SharingMode::eExclusive;
+        swapchainCreateInfo.queueFamilyIndexCount = 0;
+        swapchainCreateInfo.pQueueFamilyIndices = nullptr;
+    }
 
     poolCreateInfo.queueFamilyIndex = owner.m_familyIndeces.graphicsFamily;
 }
@@ -375,45 +535,74 @@ void RenderSystem::RenderParametersCache::updateFramebufferDependentProperties()
 
 void RenderSystem::createInstance()
 {
+    TRACE_ZONE("RenderSystem::createInstance");
     vk::Result result;
     extractResult(std::tie(result, m_instance), 
             vk::createInstanceUnique(m_paramCache.instanceCreateInfo));
     criticalVulkanAssert(result, "error creating vulkan instance");
 }
 
+// picks suitable device with best score, CHESS_VULKAN_DEVICE environment variable
+// may select device by part of its name or by its uuid
 void RenderSystem::pickPhysicalDeviceAndQueueFamily()
 {
+    TRACE_ZONE("RenderSystem::pickPhysicalDeviceAndQueueFamily");
     auto[result, physicalDevices] = m_instance->enumeratePhysicalDevices();
     criticalVulkanAssert(result, "error enumerating phisical devices");
     fassert(physicalDevices.size() != 0, "no physical devices found");
+    const char* deviceOverride = std::getenv("CHESS_VULKAN_DEVICE");
+    if (deviceOverride != nullptr && *deviceOverride == '\0')
+    {
+        // empty name would match every device
+        deviceOverride = nullptr;
+    }
+    std::optional<FamilyIndeces> pickedFamilyIndeces;
+    DeviceScore pickedScore;
+    bool pickedByOverride = false;
     for (auto& physicalDevice : physicalDevices)
     {
-        if (!isRequiredDeviceExtentionsSupported(physicalDevice))
+        auto optionalFamilyIndeces = getSuitableFamilyIndeces(physicalDevice, m_surface.get());
+        if (!optionalFamilyIndeces.has_value())
         {
             continue;
         }
-        else
+        if (deviceOverride != nullptr && matchesDeviceOverride(physicalDevice, deviceOverride))
         {
-            if (!surfaceAndSwapChainCompatible(physicalDevice, m_surface.get()))
-            {
-                continue;
-            }
+            m_physicalDevice = physicalDevice;
+            pickedFamilyIndeces = optionalFamilyIndeces;
+            pickedByOverride = true;
+            break;
         }
-        auto optionalFamilyIndeces = getFamilyIndeces(physicalDevice, m_surface.get());
-        if (optionalFamilyIndeces.has_value())
+        DeviceScore score = scorePhysicalDevice(physicalDevice);
+        if (!pickedFamilyIndeces.has_value() || score > pickedScore)
         {
             m_physicalDevice = physicalDevice;
-            m_familyIndeces = optionalFamilyIndeces.value();
-            m_paramCache.updateQueueDependentProperties();
-            m_paramCache.updatePhysicalDeviceDependentProperties();
-            return;
+            pickedFamilyIndeces = optionalFamilyIndeces;
+            pickedScore = score;
         }
     }
-    fassert(false, "no suitable device found");
+    fassert(pickedFamilyIndeces.has_value(), "no suitable device found");
+    if (deviceOverride != nullptr && !pickedByOverride)
+    {
+        std::cout << "no suitable device matches CHESS_VULKAN_DEVICE=" << deviceOverride << std::endl;
+    }
+    m_familyIndeces = pickedFamilyIndeces.value();
+
+    const vk::PhysicalDeviceProperties properties = m_physicalDevice.getProperties();
+    std::cout << "physical device: " << properties.deviceName.data()
+        << " (" << vk::to_string(properties.deviceType) << ")\n"
+        << "queue families: graphics " << m_familyIndeces.graphicsFamily
+        << ", present " << m_familyIndeces.presentationFamily
+        << ", transfer " << m_familyIndeces.transferFamily
+        << ", compute " << m_familyIndeces.computeFamily << std::endl;
+
+    m_paramCache.updateQueueDependentProperties();
+    m_paramCache.updatePhysicalDeviceDependentProperties();
 }
 
 void RenderSystem::createDevice()
 {
+    TRACE_ZONE("RenderSystem::createDevice");
     // default zero
     vk::Result result;
     extractResult(std::tie(result, m_device), m_physicalDevice.createDeviceUnique(m_paramCache.deviceCreateInfo));
@@ -423,6 +612,7 @@ void RenderSystem::createDevice()
 
 void RenderSystem::createSwapchain()
 {
+    TRACE_ZONE("RenderSystem::createSwapchain");
     vk::Result result;
     extractResult(std::tie(result, m_swapchain), m_device->createSwapchainKHRUnique(m_paramCache.swapchainCreateInfo));
     criticalVulkanAssert(result, "failed to create swapchain");
@@ -431,6 +621,7 @@ void RenderSystem::createSwapchain()
 
 void RenderSystem::createImageViews()
 {
+    TRACE_ZONE("RenderSystem::createImageViews");
     m_swapchainImages.clear();
     m_swapchainImages.reserve(m_paramCache.imageCreateInfos.size());
     for (auto& imageInfo : m_paramCache.imageCreateInfos)
@@ -444,6 +635,7 @@ void RenderSystem::createImageViews()
 
 void RenderSystem::createRenderPass()
 {
+    TRACE_ZONE("RenderSystem::createRenderPass");
     vk::Result result;
     extractResult(std::tie(result, m_renderPass), m_device->createRenderPassUnique(m_paramCache.renderPassCreateInfo));
     criticalVulkanAssert(result, "failed to create renderPass");
@@ -452,6 +644,7 @@ void RenderSystem::createRenderPass()
 
 void RenderSystem::createShaders()
 {
+    TRACE_ZONE("RenderSystem::createShaders");
     std::filesystem::path shadersFolder = getExecutableFolder() / "assets" / "shaders";
     std::vector<char> vertShaderCode = readFile(shadersFolder / "shader.vert.spv");
     std::vector<char> fragShaderCode = readFile(shadersFolder / "shader.frag.spv");
@@ -470,6 +663,7 @@ void RenderSystem::createShaders()
 
 void RenderSystem::createPipeline()
 {
+    TRACE_ZONE("RenderSystem::createPipeline");
     vk::Result result;
     extractResult(std::tie(result, m_pipeline), m_device->createGraphicsPipelineUnique({}, m_paramCache.pipelineInfo));
     criticalVulkanAssert(result, "failed to create pipeline");
@@ -477,6 +671,7 @@ void RenderSystem::createPipeline()
 
 void RenderSystem::createSyncObjects()
 {
+    TRACE_ZONE("RenderSystem::createSyncObjects");
     m_imageAvailableSemaphores.clear();
     m_imageAvailableSemaphores.reserve(parallelFrames);
     m_renderFinishedSemaphores.clear();
@@ -499,6 +694,7 @@ void RenderSystem::createSyncObjects()
 
 void RenderSystem::createCommandPool()
 {
+    TRACE_ZONE("RenderSystem::createCommandPool");
     vk::Result result;
     extractResult(std::tie(result, m_commandPool), m_device->createCommandPoolUnique(m_paramCache.poolCreateInfo));
     criticalVulkanAssert(result, "failed to create command pool");
@@ -507,6 +703,7 @@ void RenderSystem::createCommandPool()
 
 void RenderSystem::createFramebuffers()
 {
+    TRACE_ZONE("RenderSystem::createFramebuffers");
     m_framebuffers.clear();
     m_framebuffers.reserve(m_paramCache.framebufferCreateInfos.size());
     for (const auto& framebufferInfo : m_paramCache.framebufferCreateInfos)
@@ -521,6 +718,7 @@ void RenderSystem::createFramebuffers()
 
 void RenderSystem::createCommandBuffers()
 {
+    TRACE_ZONE("RenderSystem::createCommandBuffers");
     vk::Result allocateResult;
     extractResult(std::tie(allocateResult, m_commandBuffers),
             m_device->allocateCommandBuffersUnique(m_paramCache.allocateInfo));
@@ -533,7 +731,10 @@ void RenderSystem::createCommandBuffers()
 
         m_commandBuffers[i]->beginRenderPass(m_paramCache.renderPassInfos[i], vk::SubpassContents::eInline);
         m_commandBuffers[i]->bindPipeline(vk::PipelineBindPoint::eGraphics, m_pipeline.get());
-        m_commandBuffers[i]->draw(3, 1, 0, 0);
+        m_commandBuffers[i]->pushConstants(m_pipelineLayout.get(), vk::ShaderStageFlagBits::eVertex,
+                0, sizeof(BoardLayout), &m_boardLayout);
+        // instance is board index * squaresPerBoard + square, square quad is built in vertex shader
+        m_commandBuffers[i]->draw(verticesPerSquare, m_boardLayout.boardCount * squaresPerBoard, 0, 0);
         m_commandBuffers[i]->endRenderPass();
         criticalVulkanAssert(m_commandBuffers[i]->end(), "error recording command buffers");
     }
@@ -549,13 +750,42 @@ void RenderSystem::recreateSwapchain()
     createCommandBuffers();
 }
 
-RenderSystem::RenderSystem(const vkfw::Window& window) :
-    m_paramCache(*this)
+void RenderSystem::recreateOutdatedSwapchain()
+{
+    // window is minimized, swapchain is recreated once it has size again.
+    // surface may report zero extent as well, so it is checked after clamping too
+    auto isWindowMinimized = [this]()
+    {
+        return m_paramCache.windowExtent.width == 0 || m_paramCache.windowExtent.height == 0;
+    };
+    m_paramCache.updateWindowDependentProperties(m_window);
+    if (isWindowMinimized())
+    {
+        return;
+    }
+    m_paramCache.updateSurfaceCapabilitiesDependentProperties();
+    if (isWindowMinimized())
+    {
+        return;
+    }
+    m_device->waitIdle();
+    recreateSwapchain();
+    // image count of new swapchain may differ
+    imageFences.assign(m_framebuffers.size(), vk::Fence{});
+}
+
+RenderSystem::RenderSystem(const vkfw::Window& window, bool enableValidation) :
+    m_paramCache(*this, enableValidation),
+    m_window(window)
 {
+    TRACE_ZONE("RenderSystem::RenderSystem");
     m_paramCache.updateWindowDependentProperties(window);
     createInstance();
-    m_surface = vkfw::createWindowSurfaceUnique(m_instance.get(), window);
-    m_paramCache.updateSurfaceDependentProperties();
+    {
+        TRACE_ZONE("RenderSystem::createSurface");
+        m_surface = vkfw::createWindowSurfaceUnique(m_instance.get(), window);
+        m_paramCache.updateSurfaceDependentProperties();
+    }
     pickPhysicalDeviceAndQueueFamily();
     createDevice();
     createCommandPool();
@@ -568,11 +798,12 @@ RenderSystem::RenderSystem(const vkfw::Window& window) :
     createFramebuffers();
     createCommandBuffers();
     m_graphicQueue = m_device->getQueue(m_familyIndeces.graphicsFamily, 0);
-    window.callbacks()->on_window_refresh = [this](const vkfw::Window& window)
+    m_presentQueue = m_device->getQueue(m_familyIndeces.presentationFamily, 0);
+    m_transferQueue = m_device->getQueue(m_familyIndeces.transferFamily, 0);
+    m_computeQueue = m_device->getQueue(m_familyIndeces.computeFamily, 0);
+    window.callbacks()->on_window_refresh = [this](const vkfw::Window&)
     {
-        m_paramCache.updateWindowDependentProperties(window);
-        m_device->waitIdle();
-        recreateSwapchain();
+        recreateOutdatedSwapchain();
         update(0.0f);
     };
     imageFences.assign(m_framebuffers.size(), vk::Fence{});
@@ -583,9 +814,42 @@ RenderSystem::~RenderSystem()
     m_device->waitIdle();
 }
 
-void RenderSystem::init(const vkfw::Window& window)
+void RenderSystem::init(const vkfw::Window& window, bool enableValidation)
+{
+    s_instance.reset(new RenderSystem(window, enableValidation));
+}
+
+void RenderSystem::shutdown()
 {
-    s_instance.reset(new RenderSystem(window));
+    s_instance.reset();
+}
+
+bool RenderSystem::isSupported(const vkfw::Window& window)
+{
+    uint32_t glfwExtentionCount = 0;
+    const char * const* glfwExtentions = vkfw::getRequiredInstanceExtensions(&glfwExtentionCount);
+    if (glfwExtentions == nullptr)
+    {
+        return false;
+    }
+    const vk::ApplicationInfo appInfo = makeApplicationInfo();
+    vk::InstanceCreateInfo instanceCreateInfo({}, &appInfo, 0, nullptr, glfwExtentionCount, glfwExtentions);
+    auto[createInstanceResult, instance] = vk::createInstanceUnique(instanceCreateInfo);
+    if (createInstanceResult != vk::Result::eSuccess)
+    {
+        return false;
+    }
+    vk::UniqueSurfaceKHR surface = vkfw::createWindowSurfaceUnique(instance.get(), window);
+    if (!surface)
+    {
+        return false;
+    }
+    auto[enumerateResult, physicalDevices] = instance->enumeratePhysicalDevices();
+    return enumerateResult == vk::Result::eSuccess &&
+        std::any_of(physicalDevices.begin(), physicalDevices.end(), [&surface](vk::PhysicalDevice physicalDevice)
+                {
+                    return getSuitableFamilyIndeces(physicalDevice, surface.get()).has_value();
+                });
 }
 
 RenderSystem& RenderSystem::instance()
@@ -593,21 +857,40 @@ RenderSystem& RenderSystem::instance()
     return *s_instance;
 }
 
+void RenderSystem::setBoardCount(uint32_t boardCount)
+{
+    fassert(boardCount != 0, "board count should be positive");
+    if (boardCount == m_boardLayout.boardCount)
+    {
+        return;
+    }
+    uint32_t columns = 1;
+    while (columns * columns < boardCount)
+    {
+        ++columns;
+    }
+    m_boardLayout.boardCount = boardCount;
+    m_boardLayout.columns = columns;
+    m_boardLayout.rows = (boardCount + columns - 1) / columns;
+    // layout is baked into command buffers as push constants
+    m_device->waitIdle();
+    createCommandBuffers();
+}
+
 void RenderSystem::update(float dt)
 {
+    TRACE_ZONE("RenderSystem::update");
     criticalVulkanAssert(m_device->waitForFences({m_commandBufferFences[frameIndex].get()}, true, (std::numeric_limits<uint64_t>::max)()), 
             "error waiting for entering drawFrame");
     auto [acquringResult, imageIndex] = 
         m_device->acquireNextImageKHR(m_swapchain.get(), (std::numeric_limits<uint64_t>::max)(), m_imageAvailableSemaphores[frameIndex].get(), {});
-    if (acquringResult == vk::Result::eErrorOutOfDateKHR ||
-            acquringResult == vk::Result::eSuboptimalKHR)
+    if (acquringResult == vk::Result::eErrorOutOfDateKHR)
     {
+        recreateOutdatedSwapchain();
         return;
     }
-    else
-    {
-        criticalVulkanAssert(acquringResult, "error acquring image from swapchain");
-    }
+    // suboptimal image is still acquired, so it is presented before recreation
+    bool swapchainOutdated = criticalSwapchainAssert(acquringResult, "error acquring image from swapchain");
     if (imageFences[imageIndex] != vk::Fence{})
     {
         criticalVulkanAssert(m_device->waitForFences({imageFences[imageIndex]}, true, (std::numeric_limits<uint64_t>::max)()), 
@@ -621,16 +904,15 @@ void RenderSystem::update(float dt)
     criticalVulkanAssert(m_device->resetFences({m_commandBufferFences[frameIndex].get()}), "error resetting command buffer fence");
     criticalVulkanAssert(m_graphicQueue.submit(1, &submitInfo, m_commandBufferFences[frameIndex].get()),"failed to submit commands to queue");
     vk::PresentInfoKHR presentInfo(1, &m_renderFinishedSemaphores[frameIndex].get(), 1, &m_swapchain.get(), &imageIndex);
-    vk::Result presentResult = m_graphicQueue.presentKHR(presentInfo);
-    if (presentResult == vk::Result::eErrorOutOfDateKHR ||
-            presentResult == vk::Result::eSuboptimalKHR)
+    vk::Result presentResult = m_presentQueue.presentKHR(presentInfo);
+    if (criticalSwapchainAssert(presentResult, "failed to present image to Queue"))
     {
-        return;
+        swapchainOutdated = true;
     }
-    else
+    frameIndex = (frameIndex + 1) % parallelFrames;
+    if (swapchainOutdated)
     {
-        criticalVulkanAssert(presentResult, "failed to present image to Queue");
+        recreateOutdatedSwapchain();
     }
-    frameIndex = (frameIndex + 1) % parallelFrames;
 }
 
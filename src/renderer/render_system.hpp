@@ -7,21 +7,42 @@
 #include <utils/assert.hpp>
 #include <vector>
 
-inline void criticalVulkanAssert(vk::Result received, std::string message)
+inline void criticalVulkanAssert(vk::Result received, const char* message)
 {
-    criticalAssertEqual(received, vk::Result::eSuccess, std::move(message));
+    criticalAssertEqual(received, vk::Result::eSuccess, message);
+}
+
+// returns true if swapchain has to be recreated, aborts on other errors
+inline bool criticalSwapchainAssert(vk::Result received, const char* message)
+{
+    if (received == vk::Result::eErrorOutOfDateKHR ||
+            received == vk::Result::eSuboptimalKHR)
+    {
+        return true;
+    }
+    criticalVulkanAssert(received, message);
+    return false;
 }
 
 class RenderSystem
 {
 private:
+    // mirrors push constant block in shader.vert
+    struct BoardLayout
+    {
+        uint32_t boardCount;
+        uint32_t columns;
+        uint32_t rows;
+    };
+
     struct RenderParametersCache
     {
-        RenderParametersCache(RenderSystem& owner);
+        RenderParametersCache(RenderSystem& owner, bool enableValidation);
 
         void updateWindowDependentProperties(const vkfw::Window& window);
         void updateSurfaceDependentProperties();
         void updatePhysicalDeviceDependentProperties();
+        void updateSurfaceCapabilitiesDependentProperties();
         void updateQueueDependentProperties();
         void updateDeviceDependentProperties();
         void updateSwapchainDependentProperties();
@@ -39,6 +60,7 @@ private:
         vk::PhysicalDeviceFeatures deviceFeatures;
         vk::DeviceCreateInfo deviceCreateInfo;
         vk::Extent2D windowExtent;
+        uint32_t swapchainQueueFamilies[2];
         vk::SwapchainCreateInfoKHR swapchainCreateInfo;
         vk::ImageSubresourceRange imageSubresourceRange;
         std::vector<vk::ImageViewCreateInfo> imageCreateInfos;
@@ -60,6 +82,7 @@ private:
         vk::PipelineColorBlendStateCreateInfo colorBlendStateCreateInfo;
         vk::DynamicState dynamicStates[1] = { vk::DynamicState::eLineWidth};
         vk::PipelineDynamicStateCreateInfo dynamicStateInfo;
+        vk::PushConstantRange pushConstantRange;
         vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
         vk::GraphicsPipelineCreateInfo pipelineInfo;
         std::vector<vk::FramebufferCreateInfo> framebufferCreateInfos;
@@ -71,11 +94,18 @@ private:
     };
 public:
     ~RenderSystem();
-    static void init(const vkfw::Window&);
+    // validation layers are off in benchmarks, they allocate and slow down every call
+    static void init(const vkfw::Window&, bool enableValidation = true);
+    // checks without aborting that RenderSystem without validation can be created for window
+    static bool isSupported(const vkfw::Window&);
+    // destroys instance, window should outlive it
+    static void shutdown();
     static RenderSystem& instance();
     void update(float dt);
+    // lays out boards in grid, all boards are drawn with one instanced draw
+    void setBoardCount(uint32_t boardCount);
 private:
-    RenderSystem(const vkfw::Window& window);
+    RenderSystem(const vkfw::Window& window, bool enableValidation);
 
     void createInstance();
     void pickPhysicalDeviceAndQueueFamily();
@@ -91,15 +121,22 @@ private:
     void createCommandBuffers();
 
     void recreateSwapchain();
+    void recreateOutdatedSwapchain();
 
     RenderParametersCache m_paramCache;
 
+    vkfw::Window m_window;
+
     vk::UniqueInstance m_instance;
     vk::PhysicalDevice m_physicalDevice;
     vk::UniqueSurfaceKHR m_surface;
     FamilyIndeces m_familyIndeces;
     vk::UniqueDevice m_device;
     vk::Queue m_graphicQueue;
+    vk::Queue m_presentQueue;
+    // same as m_graphicQueue if device has no dedicated family
+    vk::Queue m_transferQueue;
+    vk::Queue m_computeQueue;
     vk::UniqueSwapchainKHR m_swapchain;
     std::vector<vk::UniqueImageView> m_swapchainImages;
     vk::UniqueRenderPass m_renderPass;
@@ -115,6 +152,8 @@ private:
     std::vector<vk::UniqueSemaphore> m_renderFinishedSemaphores;
     std::vector<vk::UniqueFence> m_commandBufferFences;
 
+    BoardLayout m_boardLayout = {1, 1, 1};
+
     // update data
     std::vector<vk::Fence> imageFences;
     size_t frameIndex = 0;
@@ -1,22 +1,42 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
+layout(push_constant) uniform BoardLayout {
+    uint boardCount;
+    uint columns;
+    uint rows;
+} boards;
+
 layout(location = 0) out vec3 fragColor;
 
-vec2 positions[3] = vec2[](
-    vec2(0.0, -0.5),
-    vec2(0.5, 0.5),
-    vec2(-0.5, 0.5)
+vec2 corners[6] = vec2[](
+    vec2(0.0, 0.0),
+    vec2(1.0, 0.0),
+    vec2(1.0, 1.0),
+    vec2(1.0, 1.0),
+    vec2(0.0, 1.0),
+    vec2(0.0, 0.0)
 );
 
-vec3 colors[3] = vec3[](
-    vec3(1.0, 0.0, 0.0),
-    vec3(0.0, 1.0, 0.0),
-    vec3(0.0, 0.0, 1.0)
-);
+vec3 lightSquare = vec3(0.94, 0.85, 0.71);
+vec3 darkSquare = vec3(0.71, 0.53, 0.39);
+
+// fraction of grid cell left empty around every board
+const float boardMargin = 0.05;
 
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
-}
+    // every instance is one square, instance index is board * 64 + square
+    uint board = uint(gl_InstanceIndex) / 64u;
+    uint square = uint(gl_InstanceIndex) % 64u;
+    uint file = square % 8u;
+    uint rank = square / 8u;
+
+    float cellSize = 2.0 / float(max(boards.columns, boards.rows));
+    vec2 gridOrigin = vec2(-1.0) + (vec2(2.0) - cellSize * vec2(boards.columns, boards.rows)) / 2.0;
+    vec2 cellOrigin = gridOrigin + cellSize * vec2(board % boards.columns, board / boards.columns);
+    float squareSize = cellSize * (1.0 - 2.0 * boardMargin) / 8.0;
+    vec2 squareOrigin = cellOrigin + cellSize * boardMargin + squareSize * vec2(file, 7u - rank);
 
+    gl_Position = vec4(squareOrigin + squareSize * corners[gl_VertexIndex], 0.0, 1.0);
+    fragColor = (file + rank) % 2u == 0u ? darkSquare : lightSquare;
+}
@@ -1,4 +1,6 @@
 #include <utils/assert.hpp>
+#include <cstdio>
+#include <cstdlib>
 
 void fassert(bool condition, const char * message)
 {
@@ -8,3 +10,9 @@ void fassert(bool condition, const char * message)
         abort();
     }
 }
+
+void criticalAssertFailed(const char * message, const std::string& received)
+{
+    fprintf(stderr, "%s\nerror code is %s\n", message, received.c_str());
+    abort();
+}
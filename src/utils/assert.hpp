@@ -1,12 +1,48 @@
 #pragma once
 #include <string>
+#include <type_traits>
+#include <utility>
+
+// keeps rarely taken function out of callers, so they stay small on success path
+#if defined(_MSC_VER)
+#define COLD_NOINLINE __declspec(noinline)
+#else
+#define COLD_NOINLINE __attribute__((cold, noinline))
+#endif
 
 void fassert(bool condition, const char * message);
 
+// failure path of criticalAssertEqual, prints message with received value and aborts
+[[noreturn]] COLD_NOINLINE void criticalAssertFailed(const char * message, const std::string& received);
+
+namespace assert_detail
+{
+// enums of vulkan.hpp and vkfw have to_string found by ADL
+template <typename T, typename = void>
+struct HasToString : std::false_type {};
+
+template <typename T>
+struct HasToString<T, std::void_t<decltype(to_string(std::declval<T>()))>> : std::true_type {};
+}
+
+// never inlined, so formatting code is not part of criticalAssertEqual
 template <typename T>
-void criticalAssertEqual(T received, T desired, std::string message)
+[[noreturn]] COLD_NOINLINE void criticalAssertEqualFailed(T received, const char * message)
 {
-    message += "\nerror code is " + std::to_string(static_cast<int>(received)) + "\n";
-    fassert(received == desired, message.c_str());
+    std::string receivedName = std::to_string(static_cast<int>(received));
+    if constexpr (assert_detail::HasToString<T>::value)
+    {
+        receivedName = to_string(received) + " (" + receivedName + ")";
+    }
+    criticalAssertFailed(message, receivedName);
 }
 
+// message should be string literal, success path does not allocate
+template <typename T>
+inline void criticalAssertEqual(T received, T desired, const char * message)
+{
+    if (received != desired)
+    {
+        criticalAssertEqualFailed(received, message);
+    }
+}
@@ -0,0 +1,126 @@
+#include <utils/trace.hpp>
+#ifdef CHESS_ENABLE_TRACING
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+constexpr size_t eventsPerThread = 1 << 16;
+
+struct TraceEvent
+{
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+// single producer (owning thread), single consumer (flushTrace)
+// when buffer is full new events are dropped, producer never waits
+struct ThreadBuffer
+{
+    std::array<TraceEvent, eventsPerThread> events;
+    std::atomic<uint64_t> writeIndex = 0;
+    std::atomic<uint64_t> readIndex = 0;
+    std::atomic<uint64_t> dropped = 0;
+    uint32_t threadId;
+};
+
+std::mutex s_buffersMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> s_buffers;
+
+// registration happens once per thread, so mutex is not on hot path
+std::shared_ptr<ThreadBuffer> registerThreadBuffer()
+{
+    auto buffer = std::make_shared<ThreadBuffer>();
+    std::lock_guard lock(s_buffersMutex);
+    buffer->threadId = static_cast<uint32_t>(s_buffers.size());
+    s_buffers.push_back(buffer);
+    return buffer;
+}
+
+ThreadBuffer& threadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer = registerThreadBuffer();
+    return *buffer;
+}
+
+void writeJsonString(std::ofstream& file, const char* str)
+{
+    file << '"';
+    for (; *str; ++str)
+    {
+        if (*str == '"' || *str == '\\')
+        {
+            file << '\\';
+        }
+        file << *str;
+    }
+    file << '"';
+}
+
+}
+
+void recordTraceEvent(const char* name, uint64_t begin, uint64_t end)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    const uint64_t write = buffer.writeIndex.load(std::memory_order_relaxed);
+    if (write - buffer.readIndex.load(std::memory_order_acquire) >= eventsPerThread)
+    {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[write % eventsPerThread] = TraceEvent{name, begin, end};
+    buffer.writeIndex.store(write + 1, std::memory_order_release);
+}
+
+void flushTrace(const std::filesystem::path& path)
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        return;
+    }
+    // chrome trace format expects microseconds, fractional part keeps nanoseconds
+    file.precision(3);
+    file << std::fixed << "{\"traceEvents\":[";
+    bool first = true;
+    std::lock_guard lock(s_buffersMutex);
+    for (auto& buffer : s_buffers)
+    {
+        const uint64_t read = buffer->readIndex.load(std::memory_order_relaxed);
+        const uint64_t write = buffer->writeIndex.load(std::memory_order_acquire);
+        for (uint64_t i = read; i < write; ++i)
+        {
+            const TraceEvent& event = buffer->events[i % eventsPerThread];
+            file << (first ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(file, event.name);
+            file << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << static_cast<double>(event.begin) / 1000.0
+                << ",\"dur\":" << static_cast<double>(event.end - event.begin) / 1000.0 << '}';
+            first = false;
+        }
+        buffer->readIndex.store(write, std::memory_order_release);
+    }
+    file << "\n],\"otherData\":{\"droppedEvents\":\"";
+    uint64_t dropped = 0;
+    for (auto& buffer : s_buffers)
+    {
+        dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+    }
+    file << dropped << "\"}}\n";
+}
+
+void clearTrace()
+{
+    std::lock_guard lock(s_buffersMutex);
+    for (auto& buffer : s_buffers)
+    {
+        buffer->readIndex.store(buffer->writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+#endif
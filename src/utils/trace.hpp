@@ -0,0 +1,52 @@
+#pragma once
+// Scoped tracing zones, flushed as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+// Compiled out entirely unless CHESS_ENABLE_TRACING is defined.
+#ifdef CHESS_ENABLE_TRACING
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+inline uint64_t traceNow()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// name should be string with static storage duration, only pointer is stored
+void recordTraceEvent(const char* name, uint64_t begin, uint64_t end);
+
+// writes events of all threads collected since previous flush
+void flushTrace(const std::filesystem::path& path);
+
+// drops events of all threads collected since previous flush
+void clearTrace();
+
+class TraceZone
+{
+public:
+    explicit TraceZone(const char* name) :
+        m_name(name),
+        m_begin(traceNow())
+    {
+    }
+    ~TraceZone()
+    {
+        recordTraceEvent(m_name, m_begin, traceNow());
+    }
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+private:
+    const char* m_name;
+    uint64_t m_begin;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
+#define TRACE_FLUSH(path) flushTrace(path)
+#define TRACE_CLEAR() clearTrace()
+#else
+#define TRACE_ZONE(name)
+#define TRACE_FLUSH(path)
+#define TRACE_CLEAR()
+#endif